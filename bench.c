@@ -0,0 +1,173 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+
+#include "rand_double.h"
+#include "rand_vector.h"
+
+/* Compares the batched distributions in rand_vector.h with the usual naive
+   constructions from rand_double_bounded and trig calls */
+
+#define BENCH_POINTS 1024
+#define BENCH_ROUNDS 20000
+#define BENCH_DIM 8
+#define TWO_PI 6.283185307179586
+
+static double bench_now(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static double bench_sink = 0.0;
+
+static void bench_report(const char *name, double start, size_t points) {
+    double elapsed = bench_now() - start;
+    printf("%-28s %8.2f ns/point\n", name, elapsed * 1e9 / (double)points);
+}
+
+#define BENCH(name, body) do { \
+    double bench_start = bench_now(); \
+    for (int round = 0; round < BENCH_ROUNDS; round++) { \
+        body; \
+        bench_sink += x[round % BENCH_POINTS]; \
+    } \
+    bench_report(name, bench_start, (size_t)BENCH_ROUNDS * BENCH_POINTS); \
+} while (0)
+
+static void naive_unit_2d(rand_double_gen_t *rng, double *x, double *y, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        double theta = rand_double_bounded(rng, 0.0, TWO_PI);
+        x[i] = cos(theta);
+        y[i] = sin(theta);
+    }
+}
+
+static void naive_unit_3d(rand_double_gen_t *rng, double *x, double *y, double *z, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        double cz = rand_double_bounded(rng, -1.0, 1.0);
+        double theta = rand_double_bounded(rng, 0.0, TWO_PI);
+        double r = sqrt(1.0 - cz * cz);
+        x[i] = r * cos(theta);
+        y[i] = r * sin(theta);
+        z[i] = cz;
+    }
+}
+
+static void naive_disk(rand_double_gen_t *rng, double *x, double *y, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        double r = sqrt(rand_double_uniform(rng));
+        double theta = rand_double_bounded(rng, 0.0, TWO_PI);
+        x[i] = r * cos(theta);
+        y[i] = r * sin(theta);
+    }
+}
+
+static void naive_ball_3d(rand_double_gen_t *rng, double *x, double *y, double *z, size_t n) {
+    naive_unit_3d(rng, x, y, z, n);
+    for (size_t i = 0; i < n; i++) {
+        double r = cbrt(rand_double_uniform(rng));
+        x[i] *= r;
+        y[i] *= r;
+        z[i] *= r;
+    }
+}
+
+static double naive_normal(rand_double_gen_t *rng) {
+    double u = 1.0 - rand_double_uniform(rng);
+    double theta = rand_double_bounded(rng, 0.0, TWO_PI);
+    return sqrt(-2.0 * log(u)) * cos(theta);
+}
+
+static void naive_unit_nd(rand_double_gen_t *rng, double *out, size_t dim, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        double norm2 = 0.0;
+        for (size_t d = 0; d < dim; d++) {
+            double g = naive_normal(rng);
+            out[d * n + i] = g;
+            norm2 += g * g;
+        }
+        double inv = 1.0 / sqrt(norm2);
+        for (size_t d = 0; d < dim; d++) {
+            out[d * n + i] *= inv;
+        }
+    }
+}
+
+static void naive_ball_nd(rand_double_gen_t *rng, double *out, size_t dim, size_t n) {
+    naive_unit_nd(rng, out, dim, n);
+    for (size_t i = 0; i < n; i++) {
+        double r = pow(rand_double_uniform(rng), 1.0 / (double)dim);
+        for (size_t d = 0; d < dim; d++) {
+            out[d * n + i] *= r;
+        }
+    }
+}
+
+static int compare_double(const void *a, const void *b) {
+    double da = *(const double *)a, db = *(const double *)b;
+    return (da > db) - (da < db);
+}
+
+static void naive_simplex(rand_double_gen_t *rng, double *out, size_t dim, size_t n) {
+    double cuts[BENCH_DIM + 1];
+    for (size_t i = 0; i < n; i++) {
+        cuts[0] = 0.0;
+        for (size_t d = 1; d < dim; d++) {
+            cuts[d] = rand_double_uniform(rng);
+        }
+        qsort(cuts + 1, dim - 1, sizeof(double), compare_double);
+        cuts[dim] = 1.0;
+        for (size_t d = 0; d < dim; d++) {
+            out[d * n + i] = cuts[d + 1] - cuts[d];
+        }
+    }
+}
+
+static void naive_permutation(rand_double_gen_t *rng, uint32_t *out, uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        out[i] = i;
+    }
+    for (uint32_t i = n - 1; i > 0; i--) {
+        uint32_t j = (uint32_t)rand_double_bounded(rng, 0.0, (double)(i + 1));
+        uint32_t tmp = out[i];
+        out[i] = out[j];
+        out[j] = tmp;
+    }
+}
+
+int main(void) {
+    rand_double_gen_t rng;
+    rand_double_init_seed(&rng, 1234567890123456789ULL);
+
+    static double x[BENCH_POINTS], y[BENCH_POINTS], z[BENCH_POINTS];
+    static double nd[BENCH_DIM * BENCH_POINTS];
+    static uint32_t perm[BENCH_POINTS];
+    static double alpha[BENCH_DIM];
+    for (size_t d = 0; d < BENCH_DIM; d++) {
+        alpha[d] = 0.5 + (double)d;
+    }
+
+    BENCH("naive unit 2d", naive_unit_2d(&rng, x, y, BENCH_POINTS));
+    BENCH("rand_vector_unit_2d", rand_vector_unit_2d(&rng, x, y, BENCH_POINTS));
+    BENCH("naive unit 3d", naive_unit_3d(&rng, x, y, z, BENCH_POINTS));
+    BENCH("rand_vector_unit_3d", rand_vector_unit_3d(&rng, x, y, z, BENCH_POINTS));
+    BENCH("naive disk", naive_disk(&rng, x, y, BENCH_POINTS));
+    BENCH("rand_vector_disk", rand_vector_disk(&rng, x, y, BENCH_POINTS));
+    BENCH("naive ball 3d", naive_ball_3d(&rng, x, y, z, BENCH_POINTS));
+    BENCH("rand_vector_ball_3d", rand_vector_ball_3d(&rng, x, y, z, BENCH_POINTS));
+    BENCH("naive unit 8d", (naive_unit_nd(&rng, nd, BENCH_DIM, BENCH_POINTS), x[0] = nd[0]));
+    BENCH("rand_vector_unit_nd 8d", (rand_vector_unit_nd(&rng, nd, BENCH_DIM, BENCH_POINTS), x[0] = nd[0]));
+    BENCH("naive ball 8d", (naive_ball_nd(&rng, nd, BENCH_DIM, BENCH_POINTS), x[0] = nd[0]));
+    BENCH("rand_vector_ball_nd 8d", (rand_vector_ball_nd(&rng, nd, BENCH_DIM, BENCH_POINTS), x[0] = nd[0]));
+    BENCH("naive simplex 8d", (naive_simplex(&rng, nd, BENCH_DIM, BENCH_POINTS), x[0] = nd[0]));
+    BENCH("rand_vector_simplex 8d", (rand_vector_simplex(&rng, nd, BENCH_DIM, BENCH_POINTS), x[0] = nd[0]));
+    BENCH("rand_vector_dirichlet 8d", (rand_vector_dirichlet(&rng, nd, BENCH_DIM, BENCH_POINTS, alpha), x[0] = nd[0]));
+    BENCH("naive permutation", (naive_permutation(&rng, perm, BENCH_POINTS), x[0] = perm[0]));
+    BENCH("rand_vector_permutation", (rand_vector_permutation(&rng, perm, BENCH_POINTS), x[0] = perm[0]));
+
+    printf("(checksum %g)\n", bench_sink);
+    return 0;
+}
@@ -0,0 +1,33 @@
+#ifndef CLZ_H
+#define CLZ_H
+
+#include <stdint.h>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+/* Count leading zeros of a 64-bit word. The result is undefined for x == 0,
+   callers must check for that case themselves. */
+
+static inline int clz64(const uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_clzll(x);
+#elif defined(_MSC_VER) && defined(_M_X64)
+	unsigned long index;
+	_BitScanReverse64(&index, x);
+	return 63 - (int)index;
+#else
+	int n = 0;
+	uint64_t y = x;
+	if (y <= UINT64_C(0x00000000ffffffff)) { n += 32; y <<= 32; }
+	if (y <= UINT64_C(0x0000ffffffffffff)) { n += 16; y <<= 16; }
+	if (y <= UINT64_C(0x00ffffffffffffff)) { n += 8; y <<= 8; }
+	if (y <= UINT64_C(0x0fffffffffffffff)) { n += 4; y <<= 4; }
+	if (y <= UINT64_C(0x3fffffffffffffff)) { n += 2; y <<= 2; }
+	if (y <= UINT64_C(0x7fffffffffffffff)) { n += 1; }
+	return n;
+#endif
+}
+
+#endif
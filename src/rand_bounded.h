@@ -0,0 +1,66 @@
+#ifndef RAND_BOUNDED_H
+#define RAND_BOUNDED_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+/* Lemire's nearly divisionless method for uniform integers in [0, bound),
+   see https://arxiv.org/abs/1805.10941. The high half of r * bound is the
+   result; only when the low half lands below bound do we need the modulo
+   to check for the (rare) biased case, in which the caller redraws.
+
+   These take the random word rather than a generator so every generator
+   type can share them:
+
+       uint32_t result;
+       while (!rand_bounded_u32(next_random_u32(), bound, &result));
+
+   bound must be nonzero. */
+
+static inline bool rand_bounded_u32(uint32_t r, uint32_t bound, uint32_t *result) {
+    uint64_t m = (uint64_t)r * (uint64_t)bound;
+    uint32_t low = (uint32_t)m;
+    if (low < bound) {
+        uint32_t threshold = -bound % bound;
+        if (low < threshold) return false;
+    }
+    *result = (uint32_t)(m >> 32);
+    return true;
+}
+
+/* Full 64x64 -> 128-bit multiply, returns the low half */
+static inline uint64_t rand_mul_u64(uint64_t a, uint64_t b, uint64_t *high) {
+#if defined(__SIZEOF_INT128__)
+    __uint128_t m = (__uint128_t)a * b;
+    *high = (uint64_t)(m >> 64);
+    return (uint64_t)m;
+#elif defined(_MSC_VER) && defined(_M_X64)
+    return _umul128(a, b, high);
+#else
+    uint64_t a_lo = (uint32_t)a, a_hi = a >> 32;
+    uint64_t b_lo = (uint32_t)b, b_hi = b >> 32;
+    uint64_t lo_lo = a_lo * b_lo;
+    uint64_t hi_lo = a_hi * b_lo;
+    uint64_t lo_hi = a_lo * b_hi;
+    uint64_t cross = (lo_lo >> 32) + (uint32_t)hi_lo + lo_hi;
+    *high = a_hi * b_hi + (hi_lo >> 32) + (cross >> 32);
+    return (cross << 32) | (uint32_t)lo_lo;
+#endif
+}
+
+static inline bool rand_bounded_u64(uint64_t r, uint64_t bound, uint64_t *result) {
+    uint64_t high;
+    uint64_t low = rand_mul_u64(r, bound, &high);
+    if (low < bound) {
+        uint64_t threshold = -bound % bound;
+        if (low < threshold) return false;
+    }
+    *result = high;
+    return true;
+}
+
+#endif
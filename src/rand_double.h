@@ -19,6 +19,8 @@ IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. */
 #define RAND_DOUBLE_H
 
 #include <stdint.h>
+#include <string.h>
+#include <math.h>
 
 /* This is xoshiro256+ 1.0, our best and fastest generator for floating-point
    numbers. We suggest to use its upper bits for floating-point
@@ -37,6 +39,7 @@ IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. */
 
 #include "rand_os.h"
 #include "rand_seed.h"
+#include "clz.h"
 #include "rotl.h"
 
 #define RAND_DOUBLE_STATE_SIZE 4
@@ -90,6 +93,118 @@ static inline double rand_double_bounded(rand_double_gen_t *rng, double low, dou
     return low + (high - low) * rand_double_uniform(rng);
 }
 
+/* Dense sampling: rand_double/rand_double_uniform use only the top 53 bits,
+   so every output is a multiple of 2^-53. The functions below instead pick
+   the exponent from the number of leading zeros of an (unbounded) stream
+   of random bits and fill the significand with the bits that follow, which
+   is the same as drawing a real number uniformly from [0,1) and truncating
+   it to the next representable double below. Every double in [0,1),
+   subnormals included, is returned with probability equal to its distance
+   to the next one.
+
+   The first word supplies both exponent and significand unless its top 12
+   bits are all zero, so the extra draw happens with probability 2^-12. */
+
+#define RAND_DOUBLE_MANTISSA_BITS 52
+#define RAND_DOUBLE_EXPONENT_BIAS 1023
+
+static inline double rand_double_from_bits(uint64_t bits) {
+    double d;
+    memcpy(&d, &bits, sizeof(d));
+    return d;
+}
+
+static inline uint64_t rand_double_to_bits(double d) {
+    uint64_t bits;
+    memcpy(&bits, &d, sizeof(bits));
+    return bits;
+}
+
+/* Slow path, r has its top 12 bits clear. Keeps counting leading zeros over
+   as many words as needed, then draws a fresh significand. */
+static inline uint64_t rand_double_dense_bits_slow(rand_double_gen_t *rng, uint64_t r) {
+    int lz = 0;
+    while (r == 0) {
+        lz += 64;
+        /* Below half the smallest subnormal, truncates to zero */
+        if (lz > 1073) return 0;
+        r = rand_double_raw(rng);
+    }
+    lz += clz64(r);
+
+    uint64_t mantissa = rand_double_raw(rng) >> (64 - RAND_DOUBLE_MANTISSA_BITS);
+    if (lz < RAND_DOUBLE_EXPONENT_BIAS - 1) {
+        return ((uint64_t)(RAND_DOUBLE_EXPONENT_BIAS - 1 - lz) << RAND_DOUBLE_MANTISSA_BITS) | mantissa;
+    }
+    /* Subnormal, shift the full significand down and truncate */
+    int shift = lz - (RAND_DOUBLE_EXPONENT_BIAS - 2);
+    if (shift > RAND_DOUBLE_MANTISSA_BITS) return 0;
+    return ((UINT64_C(1) << RAND_DOUBLE_MANTISSA_BITS) | mantissa) >> shift;
+}
+
+static inline uint64_t rand_double_dense_bits_from(rand_double_gen_t *rng, uint64_t r) {
+    if (r >> (64 - 12)) {
+        int lz = clz64(r);
+        uint64_t mantissa = (r << (lz + 1)) >> (64 - RAND_DOUBLE_MANTISSA_BITS);
+        return ((uint64_t)(RAND_DOUBLE_EXPONENT_BIAS - 1 - lz) << RAND_DOUBLE_MANTISSA_BITS) | mantissa;
+    }
+    return rand_double_dense_bits_slow(rng, r);
+}
+
+/* Uniform in [0,1), all representable values */
+static inline double rand_double_dense(rand_double_gen_t *rng) {
+    return rand_double_from_bits(rand_double_dense_bits_from(rng, rand_double_raw(rng)));
+}
+
+/* Uniform in (0,1). Zero has probability below 2^-1074, so rejecting it
+   costs nothing in practice. */
+static inline double rand_double_open(rand_double_gen_t *rng) {
+    uint64_t bits;
+    do {
+        bits = rand_double_dense_bits_from(rng, rand_double_raw(rng));
+    } while (bits == 0);
+    return rand_double_from_bits(bits);
+}
+
+/* Uniform in (0,1]. Same real number as rand_double_dense but rounded up
+   instead of down, i.e. the next representable double. Safe for log(u). */
+static inline double rand_double_open_closed(rand_double_gen_t *rng) {
+    return rand_double_from_bits(rand_double_dense_bits_from(rng, rand_double_raw(rng)) + 1);
+}
+
+/* Uniform in [0,1], rounded to nearest. The rounding bit is the bit right
+   after the significand, taken from the first word when it is available
+   and above the three weak low bits of xoshiro256+, otherwise drawn. */
+static inline double rand_double_closed(rand_double_gen_t *rng) {
+    uint64_t r = rand_double_raw(rng);
+    uint64_t bits = rand_double_dense_bits_from(rng, r);
+    uint64_t round;
+    if (r >> (64 - 8)) {
+        round = (r >> (64 - RAND_DOUBLE_MANTISSA_BITS - 2 - clz64(r))) & 1;
+    } else {
+        round = rand_double_raw(rng) >> 63;
+    }
+    return rand_double_from_bits(bits + round);
+}
+
+/* Uniform in [low, high), never returns high. Requires low < high, returns
+   low otherwise.
+
+   Interpolates as low * (1 - u) + high * u, so high - low can't overflow
+   and (-DBL_MAX, DBL_MAX) works. When the result rounds up to high it is
+   replaced by the next double below high, without redrawing. For intervals
+   spanning many ulps that only touches the top value, but an interval a
+   few ulps wide is not uniform over its doubles: on [1, 1 + 2 * DBL_EPSILON)
+   the two values come out with probability about 0.31 and 0.69. */
+static inline double rand_double_bounded_exclusive(rand_double_gen_t *rng, double low, double high) {
+    if (!(low < high)) return low;
+    double u = rand_double_uniform(rng);
+    double result = low * (1.0 - u) + high * u;
+    if (result >= high) return nextafter(high, low);
+    if (result < low) return low;
+    return result;
+}
+
 /* This is the jump function for the generator. It is equivalent
    to 2^128 calls to next(); it can be used to generate 2^128
    non-overlapping subsequences for parallel computations. */
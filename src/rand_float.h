@@ -16,6 +16,8 @@ ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR
 IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. */
 
 #include <stdint.h>
+#include <string.h>
+#include <math.h>
 
 /* This is xoroshiro128+ 1.0, our best and fastest small-state generator
    for floating-point numbers, but its state space is large enough only
@@ -44,6 +46,7 @@ IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. */
 #include "rand_os.h"
 #include "rand_seed.h"
 #include "rand_double.h"
+#include "clz.h"
 
 typedef rand_double_gen_t rand_float_gen_t;
 
@@ -78,6 +81,94 @@ static inline float rand_float_bounded(rand_float_gen_t *rng, float low, float h
     return low + (high - low) * rand_float_uniform(rng);
 }
 
+/* Dense sampling, see rand_double.h. Uses a full 64-bit output so the first
+   word covers exponent and significand unless its top 41 bits are zero. */
+
+#define RAND_FLOAT_MANTISSA_BITS 23
+#define RAND_FLOAT_EXPONENT_BIAS 127
+
+static inline float rand_float_from_bits(uint32_t bits) {
+    float f;
+    memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+static inline uint32_t rand_float_to_bits(float f) {
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    return bits;
+}
+
+static inline uint32_t rand_float_dense_bits_slow(rand_float_gen_t *rng, uint64_t r) {
+    int lz = 0;
+    while (r == 0) {
+        lz += 64;
+        if (lz > 148) return 0;
+        r = rand_double_raw(rng);
+    }
+    lz += clz64(r);
+
+    uint32_t mantissa = (uint32_t)(rand_double_raw(rng) >> (64 - RAND_FLOAT_MANTISSA_BITS));
+    if (lz < RAND_FLOAT_EXPONENT_BIAS - 1) {
+        return ((uint32_t)(RAND_FLOAT_EXPONENT_BIAS - 1 - lz) << RAND_FLOAT_MANTISSA_BITS) | mantissa;
+    }
+    int shift = lz - (RAND_FLOAT_EXPONENT_BIAS - 2);
+    if (shift > RAND_FLOAT_MANTISSA_BITS) return 0;
+    return ((UINT32_C(1) << RAND_FLOAT_MANTISSA_BITS) | mantissa) >> shift;
+}
+
+static inline uint32_t rand_float_dense_bits_from(rand_float_gen_t *rng, uint64_t r) {
+    if (r >> (64 - 41)) {
+        int lz = clz64(r);
+        uint32_t mantissa = (uint32_t)((r << (lz + 1)) >> (64 - RAND_FLOAT_MANTISSA_BITS));
+        return ((uint32_t)(RAND_FLOAT_EXPONENT_BIAS - 1 - lz) << RAND_FLOAT_MANTISSA_BITS) | mantissa;
+    }
+    return rand_float_dense_bits_slow(rng, r);
+}
+
+/* Uniform in [0,1), all representable values */
+static inline float rand_float_dense(rand_float_gen_t *rng) {
+    return rand_float_from_bits(rand_float_dense_bits_from(rng, rand_double_raw(rng)));
+}
+
+/* Uniform in (0,1) */
+static inline float rand_float_open(rand_float_gen_t *rng) {
+    uint32_t bits;
+    do {
+        bits = rand_float_dense_bits_from(rng, rand_double_raw(rng));
+    } while (bits == 0);
+    return rand_float_from_bits(bits);
+}
+
+/* Uniform in (0,1], rounded up */
+static inline float rand_float_open_closed(rand_float_gen_t *rng) {
+    return rand_float_from_bits(rand_float_dense_bits_from(rng, rand_double_raw(rng)) + 1);
+}
+
+/* Uniform in [0,1], rounded to nearest */
+static inline float rand_float_closed(rand_float_gen_t *rng) {
+    uint64_t r = rand_double_raw(rng);
+    uint32_t bits = rand_float_dense_bits_from(rng, r);
+    uint32_t round;
+    if (r >> (64 - 37)) {
+        round = (uint32_t)(r >> (64 - RAND_FLOAT_MANTISSA_BITS - 2 - clz64(r))) & 1;
+    } else {
+        round = (uint32_t)(rand_double_raw(rng) >> 63);
+    }
+    return rand_float_from_bits(bits + round);
+}
+
+/* Uniform in [low, high), never returns high, see
+   rand_double_bounded_exclusive for the caveats on very narrow intervals */
+static inline float rand_float_bounded_exclusive(rand_float_gen_t *rng, float low, float high) {
+    if (!(low < high)) return low;
+    float u = rand_float_uniform(rng);
+    float result = low * (1.0f - u) + high * u;
+    if (result >= high) return nextafterf(high, low);
+    if (result < low) return low;
+    return result;
+}
+
 /* This is the jump function for the generator. It is equivalent
    to 2^64 calls to next(); it can be used to generate 2^64
    non-overlapping subsequences for parallel computations. */
@@ -0,0 +1,138 @@
+#ifndef RAND_THREAD_H
+#define RAND_THREAD_H
+
+/* Per-thread generators that reseed themselves after fork().
+
+   A child process inherits the exact generator state of its parent, so
+   without intervention every worker of a pre-forking server produces the
+   same sequence. We register a pthread_atfork child handler which bumps a
+   generation counter, and each thread generator remembers the generation it
+   was seeded in. The hot path only compares two integers, no getpid() or
+   other syscall, and the reseed (from os_random_seed, mixed with the pid
+   in case /dev/urandom is unavailable) happens lazily on the next draw.
+
+   fork() isn't the only way to duplicate a process: VM snapshots and
+   checkpoint/restore clone it without any notification we could hook.
+   Applications that restore from snapshots should call rand_reseed_all()
+   on resume, which forces every generator to reseed the same way.
+
+   The same check can protect generators the application owns:
+
+       static rand_u64_gen_t rng;
+       static uint64_t rng_generation = 0;
+
+       if (rand_generation_changed(&rng_generation)) rand_u64_init(&rng);
+       uint64_t r = rand_u64(&rng);
+
+   The generation counter is per translation unit, as with everything else
+   in this header-only library. */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#include "rand_os.h"
+#include "rand_seed.h"
+#include "rand_u64.h"
+#include "rand_double.h"
+
+#ifndef HAVE_PTHREAD_ATFORK
+#define HAVE_PTHREAD_ATFORK IS_UNIX
+#endif
+
+#if HAVE_PTHREAD_ATFORK
+    #include <pthread.h>
+    #include <unistd.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    #define RAND_THREAD_LOCAL __declspec(thread)
+#else
+    #define RAND_THREAD_LOCAL _Thread_local
+#endif
+
+/* Starts at 1 so a stored generation of 0 always means "never seeded".
+   Relaxed atomics compile to plain loads and stores on the hot path, they
+   only make rand_reseed_all() from another thread well-defined. */
+static _Atomic uint64_t rand_fork_generation = 1;
+
+#if HAVE_PTHREAD_ATFORK
+static pthread_once_t rand_fork_once = PTHREAD_ONCE_INIT;
+
+static inline void rand_fork_child(void) {
+    atomic_fetch_add_explicit(&rand_fork_generation, 1, memory_order_relaxed);
+}
+
+static inline void rand_fork_register_once(void) {
+    pthread_atfork(NULL, NULL, rand_fork_child);
+}
+#endif
+
+static inline void rand_fork_register(void) {
+#if HAVE_PTHREAD_ATFORK
+    pthread_once(&rand_fork_once, rand_fork_register_once);
+#endif
+}
+
+static inline uint64_t rand_generation(void) {
+    return atomic_load_explicit(&rand_fork_generation, memory_order_relaxed);
+}
+
+/* Forces every generator tracked by a generation to reseed on next use,
+   e.g. after resuming from a VM snapshot */
+static inline void rand_reseed_all(void) {
+    atomic_fetch_add_explicit(&rand_fork_generation, 1, memory_order_relaxed);
+}
+
+/* Returns true (once) if the caller's generator needs to be (re)seeded,
+   i.e. on first use and after every fork or rand_reseed_all() */
+static inline bool rand_generation_changed(uint64_t *generation) {
+    uint64_t current = rand_generation();
+    if (*generation == current) {
+        return false;
+    }
+    if (*generation == 0) {
+        /* Register before taking the generation, so a fork in between
+           still gets noticed */
+        rand_fork_register();
+        current = rand_generation();
+    }
+    *generation = current;
+    return true;
+}
+
+/* Seed for a freshly forked or cloned process. os_random_seed only falls
+   back to time and addresses, which are identical in parent and child, so
+   mix in the pid to keep those apart too. */
+static inline uint64_t rand_reseed_seed(void) {
+    uint64_t seed = os_random_seed();
+#if HAVE_PTHREAD_ATFORK
+    seed ^= (uint64_t)getpid() * 0x9e3779b97f4a7c15;
+#endif
+    return seed;
+}
+
+static RAND_THREAD_LOCAL rand_u64_gen_t rand_u64_thread_rng;
+static RAND_THREAD_LOCAL uint64_t rand_u64_thread_generation = 0;
+
+static RAND_THREAD_LOCAL rand_double_gen_t rand_double_thread_rng;
+static RAND_THREAD_LOCAL uint64_t rand_double_thread_generation = 0;
+
+/* The calling thread's integer generator, seeded on first use and
+   reseeded after fork. Don't hold on to the pointer across a fork. */
+static inline rand_u64_gen_t *rand_u64_thread_gen(void) {
+    if (rand_generation_changed(&rand_u64_thread_generation)) {
+        rand_u64_init_seed(&rand_u64_thread_rng, rand_reseed_seed());
+    }
+    return &rand_u64_thread_rng;
+}
+
+/* Same for floating-point, also usable as a rand_float_gen_t */
+static inline rand_double_gen_t *rand_double_thread_gen(void) {
+    if (rand_generation_changed(&rand_double_thread_generation)) {
+        rand_double_init_seed(&rand_double_thread_rng, rand_reseed_seed());
+    }
+    return &rand_double_thread_rng;
+}
+
+#endif
@@ -32,6 +32,7 @@ IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. */
 
 #include "rand_os.h"
 #include "rand_seed.h"
+#include "rand_bounded.h"
 #include "rand_u64.h"
 
 #define RAND_U32_STATE_SIZE 4
@@ -57,13 +58,9 @@ static inline uint32_t rand_u32_bounded(rand_u32_gen_t *rng, uint32_t bound) {
     if (bound == 0) {
         return 0;
     }
-    uint32_t threshold = -bound % bound;
-    for (;;) {
-        uint32_t r = rand_u32(rng);
-        if (r >= threshold) {
-            return r % bound;
-        }
-    }
+    uint32_t result;
+    while (!rand_bounded_u32(rand_u32(rng), bound, &result));
+    return result;
 }
 
 static inline void rand_u32_jump(rand_u32_gen_t *rng) {
@@ -21,6 +21,7 @@ IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. */
 #include <stdint.h>
 #include "rand_os.h"
 #include "rand_seed.h"
+#include "rand_bounded.h"
 #include "rotl.h"
 
 /* This is xoshiro256++ 1.0, one of our all-purpose, rock-solid generators.
@@ -71,13 +72,9 @@ static inline uint64_t rand_u64_bounded(rand_u64_gen_t *rng, uint64_t bound) {
     if (bound == 0) {
         return 0;
     }
-    uint64_t threshold = -bound % bound;
-    for (;;) {
-        uint64_t r = rand_u64(rng);
-        if (r >= threshold) {
-            return r % bound;
-        }
-    }
+    uint64_t result;
+    while (!rand_bounded_u64(rand_u64(rng), bound, &result));
+    return result;
 }
 
 /* This is the jump function for the generator. It is equivalent
@@ -0,0 +1,384 @@
+#ifndef RAND_VECTOR_H
+#define RAND_VECTOR_H
+
+/* Batched geometric distributions on top of xoshiro256+ (rand_double_gen_t).
+
+   All functions fill n points at once in structure-of-arrays layout: the
+   2D/3D variants take one output array per coordinate, the N-dimensional
+   ones a single array of dim * n doubles where coordinate d of point i is
+   out[d * n + i]. Methods are chosen to avoid trig calls and keep rejection
+   rates low:
+
+   - unit vectors in 2D: von Neumann's method, a point in the unit disk
+     squared as a complex number, accepted with probability pi/4
+   - unit vectors in 3D: Marsaglia (1972), also pi/4
+   - unit vectors in N dimensions: normalized Gaussian vectors
+   - points in the disk: rejection from the square, pi/4
+   - points in the 3D ball: rejection from the cube, pi/6, which is still
+     cheaper than direction plus cube root
+   - points in the N-ball: normalize dim + 2 Gaussians and drop the last two
+     (Voelker, Gosmann & Stewart 2017), rejection-free
+   - points on the simplex: normalized exponentials, rejection-free
+   - Dirichlet: normalized Gamma variates (Marsaglia & Tsang 2000) */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "rand_bounded.h"
+#include "rand_double.h"
+
+/* Points per block for the N-dimensional functions, which keep a running
+   norm on the stack so the per-coordinate loops stay contiguous */
+#ifndef RAND_VECTOR_BLOCK_SIZE
+#define RAND_VECTOR_BLOCK_SIZE 64
+#endif
+
+/* Uniform in [-1,1) from the upper 53 bits */
+static inline double rand_vector_signed(rand_double_gen_t *rng) {
+    return (double)((int64_t)rand_double_raw(rng) >> 11) * 0x1.0p-52;
+}
+
+/* Two independent standard normals, Marsaglia's polar method */
+static inline void rand_vector_normal_pair(rand_double_gen_t *rng, double *a, double *b) {
+    double u, v, s;
+    do {
+        u = rand_vector_signed(rng);
+        v = rand_vector_signed(rng);
+        s = u * u + v * v;
+    } while (s >= 1.0 || s == 0.0);
+    double f = sqrt(-2.0 * log(s) / s);
+    *a = u * f;
+    *b = v * f;
+}
+
+/* A single standard normal, discards the second half of the pair */
+static inline double rand_vector_normal(rand_double_gen_t *rng) {
+    double a, b;
+    rand_vector_normal_pair(rng, &a, &b);
+    return a;
+}
+
+/* Fills n contiguous doubles with standard normals */
+static inline void rand_vector_normals(rand_double_gen_t *rng, double *out, size_t n) {
+    size_t i = 0;
+    for (; i + 1 < n; i += 2) {
+        rand_vector_normal_pair(rng, &out[i], &out[i + 1]);
+    }
+    if (i < n) {
+        out[i] = rand_vector_normal(rng);
+    }
+}
+
+/* Gamma(alpha, 1) for alpha >= 1, Marsaglia & Tsang */
+static inline double rand_vector_gamma_large(rand_double_gen_t *rng, double alpha) {
+    const double d = alpha - 1.0 / 3.0;
+    const double c = 1.0 / sqrt(9.0 * d);
+    for (;;) {
+        double x, v;
+        do {
+            x = rand_vector_normal(rng);
+            v = 1.0 + c * x;
+        } while (v <= 0.0);
+        v = v * v * v;
+        double u = rand_double_open(rng);
+        double x2 = x * x;
+        if (u < 1.0 - 0.0331 * x2 * x2) return d * v;
+        if (log(u) < 0.5 * x2 + d * (1.0 - v + log(v))) return d * v;
+    }
+}
+
+/* log of a Gamma(alpha, 1) variate. For alpha < 1 uses
+   log Gamma(alpha + 1) + log(U) / alpha, which stays finite where
+   U^(1/alpha) would underflow to zero. Requires alpha > 0, returns -INFINITY
+   otherwise (including NaN). */
+static inline double rand_vector_log_gamma(rand_double_gen_t *rng, double alpha) {
+    if (!(alpha > 0.0)) return -INFINITY;
+    if (alpha < 1.0) {
+        /* Dense sampling in (0,1] so log(U) reaches the real tail */
+        double log_u = log(rand_double_open_closed(rng));
+        return log(rand_vector_gamma_large(rng, alpha + 1.0)) + log_u / alpha;
+    }
+    return log(rand_vector_gamma_large(rng, alpha));
+}
+
+/* Gamma(alpha, 1). Requires alpha > 0, returns 0 otherwise (including NaN).
+   For small alpha the result can underflow to zero, use
+   rand_vector_log_gamma if those values matter. */
+static inline double rand_vector_gamma(rand_double_gen_t *rng, double alpha) {
+    if (!(alpha > 0.0)) return 0.0;
+    if (alpha < 1.0) {
+        return exp(rand_vector_log_gamma(rng, alpha));
+    }
+    return rand_vector_gamma_large(rng, alpha);
+}
+
+static inline void rand_vector_unit_2d(rand_double_gen_t *rng, double *x, double *y, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        double u, v, s;
+        do {
+            u = rand_vector_signed(rng);
+            v = rand_vector_signed(rng);
+            s = u * u + v * v;
+        } while (s >= 1.0 || s == 0.0);
+        /* (u + iv)^2 / |u + iv|^2 doubles the angle, which stays uniform */
+        double inv = 1.0 / s;
+        x[i] = (u * u - v * v) * inv;
+        y[i] = 2.0 * u * v * inv;
+    }
+}
+
+static inline void rand_vector_unit_3d(rand_double_gen_t *rng, double *x, double *y, double *z, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        double u, v, s;
+        do {
+            u = rand_vector_signed(rng);
+            v = rand_vector_signed(rng);
+            s = u * u + v * v;
+        } while (s >= 1.0);
+        double f = 2.0 * sqrt(1.0 - s);
+        x[i] = u * f;
+        y[i] = v * f;
+        z[i] = 1.0 - 2.0 * s;
+    }
+}
+
+/* Shared by the N-dimensional functions: fills a block of count points
+   starting at point i with normals, plus extra normals per point into
+   scratch, and returns the squared norms in norm2 */
+static inline void rand_vector_normal_block(rand_double_gen_t *rng, double *out, size_t dim, size_t n,
+                                            size_t i, size_t count, size_t extra,
+                                            double *scratch, double *norm2) {
+    for (size_t j = 0; j < count; j++) {
+        norm2[j] = 0.0;
+    }
+    for (size_t d = 0; d < dim; d++) {
+        double *col = out + d * n + i;
+        rand_vector_normals(rng, col, count);
+        for (size_t j = 0; j < count; j++) {
+            norm2[j] += col[j] * col[j];
+        }
+    }
+    for (size_t e = 0; e < extra; e++) {
+        double *col = scratch + e * RAND_VECTOR_BLOCK_SIZE;
+        rand_vector_normals(rng, col, count);
+        for (size_t j = 0; j < count; j++) {
+            norm2[j] += col[j] * col[j];
+        }
+    }
+}
+
+/* Requires dim >= 1, there is no unit vector in zero dimensions. Returns
+   false without writing anything for dim == 0, true otherwise. */
+static inline bool rand_vector_unit_nd(rand_double_gen_t *rng, double *out, size_t dim, size_t n) {
+    if (dim == 0) return false;
+    double norm2[RAND_VECTOR_BLOCK_SIZE];
+    for (size_t i = 0; i < n; i += RAND_VECTOR_BLOCK_SIZE) {
+        size_t count = n - i < RAND_VECTOR_BLOCK_SIZE ? n - i : RAND_VECTOR_BLOCK_SIZE;
+        rand_vector_normal_block(rng, out, dim, n, i, count, 0, NULL, norm2);
+        for (size_t j = 0; j < count; j++) {
+            /* An all-zero Gaussian vector has probability zero in theory
+               and around 2^-53 per coordinate in practice, redraw it */
+            while (norm2[j] == 0.0) {
+                for (size_t d = 0; d < dim; d++) {
+                    double g = rand_vector_normal(rng);
+                    out[d * n + i + j] = g;
+                    norm2[j] += g * g;
+                }
+            }
+            norm2[j] = 1.0 / sqrt(norm2[j]);
+        }
+        for (size_t d = 0; d < dim; d++) {
+            double *col = out + d * n + i;
+            for (size_t j = 0; j < count; j++) {
+                col[j] *= norm2[j];
+            }
+        }
+    }
+    return true;
+}
+
+static inline void rand_vector_disk(rand_double_gen_t *rng, double *x, double *y, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        double u, v;
+        do {
+            u = rand_vector_signed(rng);
+            v = rand_vector_signed(rng);
+        } while (u * u + v * v >= 1.0);
+        x[i] = u;
+        y[i] = v;
+    }
+}
+
+static inline void rand_vector_ball_3d(rand_double_gen_t *rng, double *x, double *y, double *z, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        double u, v, w;
+        do {
+            u = rand_vector_signed(rng);
+            v = rand_vector_signed(rng);
+            w = rand_vector_signed(rng);
+        } while (u * u + v * v + w * w >= 1.0);
+        x[i] = u;
+        y[i] = v;
+        z[i] = w;
+    }
+}
+
+static inline void rand_vector_ball_nd(rand_double_gen_t *rng, double *out, size_t dim, size_t n) {
+    double norm2[RAND_VECTOR_BLOCK_SIZE];
+    double scratch[2 * RAND_VECTOR_BLOCK_SIZE];
+    for (size_t i = 0; i < n; i += RAND_VECTOR_BLOCK_SIZE) {
+        size_t count = n - i < RAND_VECTOR_BLOCK_SIZE ? n - i : RAND_VECTOR_BLOCK_SIZE;
+        rand_vector_normal_block(rng, out, dim, n, i, count, 2, scratch, norm2);
+        for (size_t j = 0; j < count; j++) {
+            /* All dim + 2 normals zero, same as the center of the ball */
+            norm2[j] = norm2[j] > 0.0 ? 1.0 / sqrt(norm2[j]) : 0.0;
+        }
+        for (size_t d = 0; d < dim; d++) {
+            double *col = out + d * n + i;
+            for (size_t j = 0; j < count; j++) {
+                col[j] *= norm2[j];
+            }
+        }
+    }
+}
+
+/* Uniform on the standard simplex: dim non-negative coordinates summing to 1.
+   Requires dim >= 1, returns false without writing anything for dim == 0. */
+static inline bool rand_vector_simplex(rand_double_gen_t *rng, double *out, size_t dim, size_t n) {
+    if (dim == 0) return false;
+    double sum[RAND_VECTOR_BLOCK_SIZE];
+    for (size_t i = 0; i < n; i += RAND_VECTOR_BLOCK_SIZE) {
+        size_t count = n - i < RAND_VECTOR_BLOCK_SIZE ? n - i : RAND_VECTOR_BLOCK_SIZE;
+        for (size_t j = 0; j < count; j++) {
+            sum[j] = 0.0;
+        }
+        for (size_t d = 0; d < dim; d++) {
+            double *col = out + d * n + i;
+            for (size_t j = 0; j < count; j++) {
+                /* Dense sampling in (0,1] keeps the exponential tail exact */
+                col[j] = -log(rand_double_open_closed(rng));
+                sum[j] += col[j];
+            }
+        }
+        for (size_t j = 0; j < count; j++) {
+            /* Every U was exactly 1, probability 2^-53 per coordinate,
+               redraw the point */
+            while (sum[j] == 0.0) {
+                for (size_t d = 0; d < dim; d++) {
+                    double e = -log(rand_double_open_closed(rng));
+                    out[d * n + i + j] = e;
+                    sum[j] += e;
+                }
+            }
+            sum[j] = 1.0 / sum[j];
+        }
+        for (size_t d = 0; d < dim; d++) {
+            double *col = out + d * n + i;
+            for (size_t j = 0; j < count; j++) {
+                col[j] *= sum[j];
+            }
+        }
+    }
+    return true;
+}
+
+/* Dirichlet(alpha[0], ..., alpha[dim - 1]). Requires dim >= 1 and every
+   alpha > 0 (not NaN), otherwise returns false without writing anything.
+
+   When some alpha < 1 the Gamma variates are kept in log space and each
+   point is normalized with a log-sum-exp: for small alpha they routinely
+   underflow to zero together, while the true distribution puts almost all
+   of its mass next to the vertices. */
+static inline bool rand_vector_dirichlet(rand_double_gen_t *rng, double *out, size_t dim, size_t n, const double *alpha) {
+    if (dim == 0) return false;
+    bool log_space = false;
+    for (size_t d = 0; d < dim; d++) {
+        if (!(alpha[d] > 0.0)) return false;
+        if (alpha[d] < 1.0) log_space = true;
+    }
+
+    double sum[RAND_VECTOR_BLOCK_SIZE];
+    for (size_t i = 0; i < n; i += RAND_VECTOR_BLOCK_SIZE) {
+        size_t count = n - i < RAND_VECTOR_BLOCK_SIZE ? n - i : RAND_VECTOR_BLOCK_SIZE;
+        if (log_space) {
+            /* sum holds the running max of the logs first */
+            for (size_t j = 0; j < count; j++) {
+                sum[j] = -INFINITY;
+            }
+            for (size_t d = 0; d < dim; d++) {
+                double *col = out + d * n + i;
+                for (size_t j = 0; j < count; j++) {
+                    col[j] = rand_vector_log_gamma(rng, alpha[d]);
+                    if (col[j] > sum[j]) sum[j] = col[j];
+                }
+            }
+            for (size_t d = 0; d < dim; d++) {
+                double *col = out + d * n + i;
+                for (size_t j = 0; j < count; j++) {
+                    col[j] = exp(col[j] - sum[j]);
+                }
+            }
+        } else {
+            for (size_t d = 0; d < dim; d++) {
+                double *col = out + d * n + i;
+                for (size_t j = 0; j < count; j++) {
+                    col[j] = rand_vector_gamma_large(rng, alpha[d]);
+                }
+            }
+        }
+        /* The largest term is 1 in log space and every term is positive
+           otherwise, so the sum can't be zero */
+        for (size_t j = 0; j < count; j++) {
+            sum[j] = 0.0;
+        }
+        for (size_t d = 0; d < dim; d++) {
+            double *col = out + d * n + i;
+            for (size_t j = 0; j < count; j++) {
+                sum[j] += col[j];
+            }
+        }
+        for (size_t j = 0; j < count; j++) {
+            sum[j] = 1.0 / sum[j];
+        }
+        for (size_t d = 0; d < dim; d++) {
+            double *col = out + d * n + i;
+            for (size_t j = 0; j < count; j++) {
+                col[j] *= sum[j];
+            }
+        }
+    }
+    return true;
+}
+
+/* Uniform in [0, bound), same Lemire path as rand_u32_bounded but on the
+   upper bits of xoshiro256+, whose lowest bits are weak */
+static inline uint32_t rand_vector_index(rand_double_gen_t *rng, uint32_t bound) {
+    uint32_t result;
+    while (!rand_bounded_u32((uint32_t)(rand_double_raw(rng) >> 32), bound, &result));
+    return result;
+}
+
+/* Shuffles values in place, Fisher-Yates */
+static inline void rand_vector_shuffle(rand_double_gen_t *rng, uint32_t *values, uint32_t n) {
+    for (uint32_t i = n; i > 1; i--) {
+        uint32_t j = rand_vector_index(rng, i);
+        uint32_t tmp = values[i - 1];
+        values[i - 1] = values[j];
+        values[j] = tmp;
+    }
+}
+
+/* A uniformly random permutation of 0..n-1, inside-out Fisher-Yates */
+static inline void rand_vector_permutation(rand_double_gen_t *rng, uint32_t *out, uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t j = rand_vector_index(rng, i + 1);
+        if (j != i) {
+            out[i] = out[j];
+        }
+        out[j] = i;
+    }
+}
+
+#endif
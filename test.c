@@ -9,6 +9,12 @@
 #include "rand_u64.h"
 #include "rand_float.h"
 #include "rand_double.h"
+#include "rand_thread.h"
+#include "rand_vector.h"
+
+#if HAVE_PTHREAD_ATFORK
+#include <sys/wait.h>
+#endif
 
 TEST rand32_test(void) {
     rand_u32_gen_t rng;
@@ -52,6 +58,24 @@ TEST rand64_bounded_test(void) {
     PASS();
 }
 
+TEST rand_bounded_test(void) {
+    uint32_t result32 = 0;
+    ASSERT(rand_bounded_u32(UINT32_MAX, 10, &result32));
+    ASSERT_EQ(result32, 9);
+    /* 2^32 % 3 == 1, so the lowest product is the one biased value */
+    ASSERT_FALSE(rand_bounded_u32(0, 3, &result32));
+    ASSERT(rand_bounded_u32(1, 3, &result32));
+    ASSERT_EQ(result32, 0);
+
+    uint64_t result64 = 0;
+    ASSERT(rand_bounded_u64(UINT64_MAX, 10, &result64));
+    ASSERT_EQ(result64, 9);
+    ASSERT_FALSE(rand_bounded_u64(0, 3, &result64));
+    ASSERT(rand_bounded_u64(UINT64_C(1) << 63, 1001, &result64));
+    ASSERT_EQ(result64, 500);
+    PASS();
+}
+
 TEST rand_float_uniform_test(void) {
     rand_float_gen_t rng;
     rand_float_init(&rng);
@@ -102,6 +126,330 @@ TEST rand_double_test(void) {
     PASS();
 }
 
+TEST rand_float_dense_test(void) {
+    rand_float_gen_t rng;
+    rand_float_init(&rng);
+    for (int i = 0; i < 1000; i++) {
+        float random_value = rand_float_dense(&rng);
+        ASSERT_LT(random_value, 1.0f);
+        ASSERT_GTE(random_value, 0.0f);
+    }
+    PASS();
+}
+
+TEST rand_float_intervals_test(void) {
+    rand_float_gen_t rng;
+    rand_float_init(&rng);
+    for (int i = 0; i < 1000; i++) {
+        float random_value = rand_float_open(&rng);
+        ASSERT_LT(random_value, 1.0f);
+        ASSERT_GT(random_value, 0.0f);
+        random_value = rand_float_open_closed(&rng);
+        ASSERT_LTE(random_value, 1.0f);
+        ASSERT_GT(random_value, 0.0f);
+        random_value = rand_float_closed(&rng);
+        ASSERT_LTE(random_value, 1.0f);
+        ASSERT_GTE(random_value, 0.0f);
+    }
+    PASS();
+}
+
+TEST rand_float_bounded_exclusive_test(void) {
+    rand_float_gen_t rng;
+    rand_float_init(&rng);
+    float high = 1.0f + FLT_EPSILON;
+    for (int i = 0; i < 1000; i++) {
+        float random_value = rand_float_bounded_exclusive(&rng, 1.0f, high);
+        ASSERT_LT(random_value, high);
+        ASSERT_GTE(random_value, 1.0f);
+    }
+    /* high - low overflows, must neither hang nor return inf */
+    for (int i = 0; i < 1000; i++) {
+        float random_value = rand_float_bounded_exclusive(&rng, -FLT_MAX, FLT_MAX);
+        ASSERT_LT(random_value, FLT_MAX);
+        ASSERT_GTE(random_value, -FLT_MAX);
+    }
+    PASS();
+}
+
+TEST rand_double_dense_test(void) {
+    rand_double_gen_t rng;
+    rand_double_init(&rng);
+    for (int i = 0; i < 1000; i++) {
+        double random_value = rand_double_dense(&rng);
+        ASSERT_LT(random_value, 1.0);
+        ASSERT_GTE(random_value, 0.0);
+    }
+    PASS();
+}
+
+TEST rand_double_dense_tail_test(void) {
+    rand_double_gen_t rng;
+    rand_double_init_seed(&rng, 42);
+    /* An all-zero first word keeps counting leading zeros into the next
+       word, so the result is below 2^-64, which the 53-bit path can't
+       produce (its smallest nonzero value is 2^-53) */
+    ASSERT(rand_double_from_bits(rand_double_dense_bits_from(&rng, 0)) < 0x1.0p-64);
+    /* 23 leading zeros takes the slow path and sets the exponent to -24 */
+    double random_value = rand_double_from_bits(rand_double_dense_bits_from(&rng, UINT64_C(1) << 40));
+    ASSERT_GTE(random_value, 0x1.0p-24);
+    ASSERT_LT(random_value, 0x1.0p-23);
+    /* Leading one and zero significand on the fast path is exactly 0.5 */
+    ASSERT_EQ(rand_double_from_bits(rand_double_dense_bits_from(&rng, UINT64_C(1) << 63)), 0.5);
+    PASS();
+}
+
+TEST rand_float_dense_subnormal_test(void) {
+    /* s[0] + s[3] == 0 makes the first output zero, so an all-zero input
+       word followed by that draw gives at least 128 leading zeros, past the
+       smallest normal float (2^-126) and into the subnormal branch */
+    rand_float_gen_t rng = {{0, UINT64_C(1) << 63, 1, 0}};
+    rand_float_gen_t expected_rng = rng;
+    ASSERT_EQ(rand_double_raw(&expected_rng), 0);
+    uint64_t r = rand_double_raw(&expected_rng);
+    uint64_t mantissa = rand_double_raw(&expected_rng) >> (64 - RAND_FLOAT_MANTISSA_BITS);
+    ASSERT(r != 0);
+    int lz = 128 + clz64(r);
+
+    float random_value = rand_float_from_bits(rand_float_dense_bits_from(&rng, 0));
+    /* The real number the bits stand for, exact in double precision */
+    double u = ldexp((double)((UINT64_C(1) << RAND_FLOAT_MANTISSA_BITS) | mantissa),
+                     -1 - lz - RAND_FLOAT_MANTISSA_BITS);
+    ASSERT_LT(random_value, FLT_MIN);
+    ASSERT_GT(random_value, 0.0f);
+    /* Truncated to the subnormal grid of 2^-149 */
+    ASSERT_LTE((double)random_value, u);
+    ASSERT_LT(u - (double)random_value, 0x1.0p-149);
+    ASSERT_EQ(memcmp(rng.state, expected_rng.state, sizeof(rng.state)), 0);
+    PASS();
+}
+
+TEST rand_double_intervals_test(void) {
+    rand_double_gen_t rng;
+    rand_double_init(&rng);
+    for (int i = 0; i < 1000; i++) {
+        double random_value = rand_double_open(&rng);
+        ASSERT_LT(random_value, 1.0);
+        ASSERT_GT(random_value, 0.0);
+        random_value = rand_double_open_closed(&rng);
+        ASSERT_LTE(random_value, 1.0);
+        ASSERT_GT(random_value, 0.0);
+        random_value = rand_double_closed(&rng);
+        ASSERT_LTE(random_value, 1.0);
+        ASSERT_GTE(random_value, 0.0);
+    }
+    PASS();
+}
+
+TEST rand_double_bounded_exclusive_test(void) {
+    rand_double_gen_t rng;
+    rand_double_init(&rng);
+    double high = 1.0 + DBL_EPSILON;
+    for (int i = 0; i < 1000; i++) {
+        double random_value = rand_double_bounded_exclusive(&rng, 1.0, high);
+        ASSERT_LT(random_value, high);
+        ASSERT_GTE(random_value, 1.0);
+    }
+    for (int i = 0; i < 1000; i++) {
+        double random_value = rand_double_bounded_exclusive(&rng, -DBL_MAX, DBL_MAX);
+        ASSERT_LT(random_value, DBL_MAX);
+        ASSERT_GTE(random_value, -DBL_MAX);
+    }
+    PASS();
+}
+
+TEST rand_thread_gen_test(void) {
+    rand_u64_gen_t *rng = rand_u64_thread_gen();
+    ASSERT_EQ(rng, rand_u64_thread_gen());
+    rand_u64(rng);
+    rand_double_gen_t *drng = rand_double_thread_gen();
+    double random_value = rand_double_uniform(drng);
+    ASSERT_LT(random_value, 1.0);
+    ASSERT_GTE(random_value, 0.0);
+    PASS();
+}
+
+TEST rand_reseed_all_test(void) {
+    rand_u64_gen_t before = *rand_u64_thread_gen();
+    uint64_t generation = 0;
+    ASSERT(rand_generation_changed(&generation));
+    ASSERT_FALSE(rand_generation_changed(&generation));
+
+    rand_reseed_all();
+    ASSERT(rand_generation_changed(&generation));
+    rand_u64_gen_t after = *rand_u64_thread_gen();
+    ASSERT(memcmp(before.state, after.state, sizeof(before.state)) != 0);
+    PASS();
+}
+
+#if HAVE_PTHREAD_ATFORK
+TEST rand_fork_reseed_test(void) {
+    uint64_t generation = 0;
+    rand_generation_changed(&generation);
+    /* Make sure the parent's generator is seeded before the fork */
+    rand_u64_gen_t parent = *rand_u64_thread_gen();
+
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    pid_t pid = fork();
+    ASSERT(pid >= 0);
+    if (pid == 0) {
+        uint64_t values[2];
+        values[0] = rand_u64(rand_u64_thread_gen());
+        values[1] = rand_generation_changed(&generation);
+        ssize_t written = write(fds[1], values, sizeof(values));
+        _exit(written == (ssize_t)sizeof(values) ? 0 : 1);
+    }
+    close(fds[1]);
+    uint64_t values[2];
+    ssize_t sz = read(fds[0], values, sizeof(values));
+    close(fds[0]);
+    int status;
+    waitpid(pid, &status, 0);
+    ASSERT_EQ(sz, (ssize_t)sizeof(values));
+    ASSERT(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    ASSERT(values[0] != rand_u64(&parent));
+    ASSERT_EQ(values[1], 1);
+    ASSERT_FALSE(rand_generation_changed(&generation));
+    PASS();
+}
+#endif
+
+#define VECTOR_TEST_POINTS 100
+#define VECTOR_TEST_DIM 5
+
+TEST rand_vector_unit_test(void) {
+    rand_double_gen_t rng;
+    rand_double_init(&rng);
+    double x[VECTOR_TEST_POINTS], y[VECTOR_TEST_POINTS], z[VECTOR_TEST_POINTS];
+    rand_vector_unit_2d(&rng, x, y, VECTOR_TEST_POINTS);
+    for (size_t i = 0; i < VECTOR_TEST_POINTS; i++) {
+        ASSERT_IN_RANGE(1.0, x[i] * x[i] + y[i] * y[i], 1e-12);
+    }
+    rand_vector_unit_3d(&rng, x, y, z, VECTOR_TEST_POINTS);
+    for (size_t i = 0; i < VECTOR_TEST_POINTS; i++) {
+        ASSERT_IN_RANGE(1.0, x[i] * x[i] + y[i] * y[i] + z[i] * z[i], 1e-12);
+    }
+    double out[VECTOR_TEST_DIM * VECTOR_TEST_POINTS];
+    rand_vector_unit_nd(&rng, out, VECTOR_TEST_DIM, VECTOR_TEST_POINTS);
+    for (size_t i = 0; i < VECTOR_TEST_POINTS; i++) {
+        double norm2 = 0.0;
+        for (size_t d = 0; d < VECTOR_TEST_DIM; d++) {
+            norm2 += out[d * VECTOR_TEST_POINTS + i] * out[d * VECTOR_TEST_POINTS + i];
+        }
+        ASSERT_IN_RANGE(1.0, norm2, 1e-12);
+    }
+    PASS();
+}
+
+TEST rand_vector_ball_test(void) {
+    rand_double_gen_t rng;
+    rand_double_init(&rng);
+    double x[VECTOR_TEST_POINTS], y[VECTOR_TEST_POINTS], z[VECTOR_TEST_POINTS];
+    rand_vector_disk(&rng, x, y, VECTOR_TEST_POINTS);
+    for (size_t i = 0; i < VECTOR_TEST_POINTS; i++) {
+        ASSERT_LT(x[i] * x[i] + y[i] * y[i], 1.0);
+    }
+    rand_vector_ball_3d(&rng, x, y, z, VECTOR_TEST_POINTS);
+    for (size_t i = 0; i < VECTOR_TEST_POINTS; i++) {
+        ASSERT_LT(x[i] * x[i] + y[i] * y[i] + z[i] * z[i], 1.0);
+    }
+    double out[VECTOR_TEST_DIM * VECTOR_TEST_POINTS];
+    rand_vector_ball_nd(&rng, out, VECTOR_TEST_DIM, VECTOR_TEST_POINTS);
+    for (size_t i = 0; i < VECTOR_TEST_POINTS; i++) {
+        double norm2 = 0.0;
+        for (size_t d = 0; d < VECTOR_TEST_DIM; d++) {
+            norm2 += out[d * VECTOR_TEST_POINTS + i] * out[d * VECTOR_TEST_POINTS + i];
+        }
+        ASSERT_LT(norm2, 1.0);
+    }
+    PASS();
+}
+
+TEST rand_vector_simplex_test(void) {
+    rand_double_gen_t rng;
+    rand_double_init(&rng);
+    double out[VECTOR_TEST_DIM * VECTOR_TEST_POINTS];
+    double alpha[VECTOR_TEST_DIM] = {0.1, 0.5, 1.0, 2.0, 10.0};
+    for (int k = 0; k < 2; k++) {
+        if (k == 0) {
+            rand_vector_simplex(&rng, out, VECTOR_TEST_DIM, VECTOR_TEST_POINTS);
+        } else {
+            rand_vector_dirichlet(&rng, out, VECTOR_TEST_DIM, VECTOR_TEST_POINTS, alpha);
+        }
+        for (size_t i = 0; i < VECTOR_TEST_POINTS; i++) {
+            double sum = 0.0;
+            for (size_t d = 0; d < VECTOR_TEST_DIM; d++) {
+                ASSERT_GTE(out[d * VECTOR_TEST_POINTS + i], 0.0);
+                sum += out[d * VECTOR_TEST_POINTS + i];
+            }
+            ASSERT_IN_RANGE(1.0, sum, 1e-12);
+        }
+    }
+    PASS();
+}
+
+TEST rand_vector_dirichlet_small_alpha_test(void) {
+    rand_double_gen_t rng;
+    rand_double_init_seed(&rng, 3);
+    /* Beta(0.001, 0.001) puts about 0.5% of its mass in [0.01, 0.99], the
+       rest next to 0 or 1. Underflowing gammas used to collapse the point
+       onto (0.5, 0.5) instead. */
+    double alpha[2] = {0.001, 0.001};
+    double out[2 * VECTOR_TEST_POINTS];
+    size_t middle = 0;
+    for (int k = 0; k < 10; k++) {
+        rand_vector_dirichlet(&rng, out, 2, VECTOR_TEST_POINTS, alpha);
+        for (size_t i = 0; i < VECTOR_TEST_POINTS; i++) {
+            double x = out[i], y = out[VECTOR_TEST_POINTS + i];
+            ASSERT_GTE(x, 0.0);
+            ASSERT_GTE(y, 0.0);
+            ASSERT_IN_RANGE(1.0, x + y, 1e-12);
+            if (x > 0.01 && x < 0.99) middle++;
+        }
+    }
+    ASSERT_LT(middle, 50);
+    PASS();
+}
+
+TEST rand_vector_preconditions_test(void) {
+    rand_double_gen_t rng;
+    rand_double_init(&rng);
+    double out[VECTOR_TEST_POINTS];
+    /* Invalid parameters must be reported instead of spinning */
+    ASSERT_FALSE(rand_vector_unit_nd(&rng, out, 0, VECTOR_TEST_POINTS));
+    ASSERT_FALSE(rand_vector_simplex(&rng, out, 0, VECTOR_TEST_POINTS));
+    double alpha[2] = {1.0, 0.0};
+    ASSERT_FALSE(rand_vector_dirichlet(&rng, out, 0, VECTOR_TEST_POINTS / 2, alpha));
+    ASSERT_FALSE(rand_vector_dirichlet(&rng, out, 2, VECTOR_TEST_POINTS / 2, alpha));
+    alpha[1] = NAN;
+    ASSERT_FALSE(rand_vector_dirichlet(&rng, out, 2, VECTOR_TEST_POINTS / 2, alpha));
+    alpha[1] = 0.5;
+    ASSERT(rand_vector_dirichlet(&rng, out, 2, VECTOR_TEST_POINTS / 2, alpha));
+    ASSERT(rand_vector_unit_nd(&rng, out, 1, VECTOR_TEST_POINTS));
+    ASSERT(rand_vector_simplex(&rng, out, 1, VECTOR_TEST_POINTS));
+    ASSERT_EQ(rand_vector_gamma(&rng, 0.0), 0.0);
+    ASSERT_EQ(rand_vector_gamma(&rng, -1.0), 0.0);
+    ASSERT_EQ(rand_vector_log_gamma(&rng, NAN), -INFINITY);
+    PASS();
+}
+
+TEST rand_vector_permutation_test(void) {
+    rand_double_gen_t rng;
+    rand_double_init(&rng);
+    uint32_t perm[VECTOR_TEST_POINTS];
+    bool seen[VECTOR_TEST_POINTS] = {false};
+    rand_vector_permutation(&rng, perm, VECTOR_TEST_POINTS);
+    rand_vector_shuffle(&rng, perm, VECTOR_TEST_POINTS);
+    for (size_t i = 0; i < VECTOR_TEST_POINTS; i++) {
+        ASSERT_LT(perm[i], VECTOR_TEST_POINTS);
+        ASSERT_FALSE(seen[perm[i]]);
+        seen[perm[i]] = true;
+    }
+    PASS();
+}
+
 // Main test suite
 SUITE(random_tests) {
     RUN_TEST(rand32_test);
@@ -110,12 +458,32 @@ SUITE(random_tests) {
     RUN_TEST(rand64_test);
     RUN_TEST(rand64_seed_test);
     RUN_TEST(rand64_bounded_test);
+    RUN_TEST(rand_bounded_test);
     RUN_TEST(rand_float_test);
     RUN_TEST(rand_float_uniform_test);
     RUN_TEST(rand_float_bounded_test);
+    RUN_TEST(rand_float_dense_test);
+    RUN_TEST(rand_float_intervals_test);
+    RUN_TEST(rand_float_bounded_exclusive_test);
+    RUN_TEST(rand_float_dense_subnormal_test);
     RUN_TEST(rand_double_test);
     RUN_TEST(rand_double_uniform_test);
     RUN_TEST(rand_double_bounded_test);
+    RUN_TEST(rand_double_dense_test);
+    RUN_TEST(rand_double_dense_tail_test);
+    RUN_TEST(rand_double_intervals_test);
+    RUN_TEST(rand_double_bounded_exclusive_test);
+    RUN_TEST(rand_vector_unit_test);
+    RUN_TEST(rand_vector_ball_test);
+    RUN_TEST(rand_vector_simplex_test);
+    RUN_TEST(rand_vector_dirichlet_small_alpha_test);
+    RUN_TEST(rand_vector_preconditions_test);
+    RUN_TEST(rand_vector_permutation_test);
+    RUN_TEST(rand_thread_gen_test);
+    RUN_TEST(rand_reseed_all_test);
+#if HAVE_PTHREAD_ATFORK
+    RUN_TEST(rand_fork_reseed_test);
+#endif
 }
 
 GREATEST_MAIN_DEFS();